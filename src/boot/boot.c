@@ -0,0 +1,107 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 G2Labs Grzegorz Grzęda
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+//----------------------------------------------------------------------------------------------------------------------
+#include "boot.h"
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/spinlock.h>
+//----------------------------------------------------------------------------------------------------------------------
+#define BOOT_MAX_PHASES 16
+//----------------------------------------------------------------------------------------------------------------------
+LOG_MODULE_REGISTER(boot, LOG_LEVEL_INF);
+//----------------------------------------------------------------------------------------------------------------------
+static boot_phase_t boot_phases[BOOT_MAX_PHASES];
+static size_t boot_phase_count = 0;
+static struct k_spinlock boot_lock;
+//----------------------------------------------------------------------------------------------------------------------
+void boot_mark(const char* name) {
+    uint64_t timestamp_us = k_ticks_to_us_floor64(k_uptime_ticks());
+
+    k_spinlock_key_t key = k_spin_lock(&boot_lock);
+    bool stored = boot_phase_count < BOOT_MAX_PHASES;
+    if (stored) {
+        boot_phases[boot_phase_count].name = name;
+        boot_phases[boot_phase_count].timestamp_us = timestamp_us;
+        boot_phase_count++;
+    }
+    k_spin_unlock(&boot_lock, key);
+
+    if (!stored) {
+        LOG_WRN("Boot phase %s not recorded, timeline full", name);
+        return;
+    }
+    LOG_INF("Boot phase %s at %llu us", name, timestamp_us);
+}
+//----------------------------------------------------------------------------------------------------------------------
+size_t boot_get_phase_count(void) {
+    k_spinlock_key_t key = k_spin_lock(&boot_lock);
+    size_t count = boot_phase_count;
+    k_spin_unlock(&boot_lock, key);
+    return count;
+}
+//----------------------------------------------------------------------------------------------------------------------
+int boot_get_phase(size_t index, boot_phase_t* phase) {
+    if (!phase) {
+        return -EINVAL;
+    }
+    k_spinlock_key_t key = k_spin_lock(&boot_lock);
+    int err = -ENOENT;
+    if (index < boot_phase_count) {
+        *phase = boot_phases[index];
+        err = 0;
+    }
+    k_spin_unlock(&boot_lock, key);
+    return err;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int boot_mark_post_kernel(void) {
+    boot_mark("kernel started");
+    return 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int boot_mark_application(void) {
+    boot_mark("drivers ready");
+    return 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+SYS_INIT(boot_mark_post_kernel, POST_KERNEL, 0);
+SYS_INIT(boot_mark_application, APPLICATION, 0);
+//----------------------------------------------------------------------------------------------------------------------
+static int cmd_boot(const struct shell* sh, size_t argc, char** argv) {
+    shell_print(sh, "%-28s %12s %12s", "phase", "time [us]", "delta [us]");
+    uint64_t previous_us = 0;
+    for (size_t i = 0; i < boot_get_phase_count(); i++) {
+        boot_phase_t phase;
+        if (boot_get_phase(i, &phase)) {
+            break;
+        }
+        shell_print(sh, "%-28s %12llu %12llu", phase.name, phase.timestamp_us, phase.timestamp_us - previous_us);
+        previous_us = phase.timestamp_us;
+    }
+    return 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+SHELL_SUBCMD_ADD((psu), boot, NULL, "Show the boot timeline measured from reset", cmd_boot, 1, 0);
+//----------------------------------------------------------------------------------------------------------------------
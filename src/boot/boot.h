@@ -0,0 +1,41 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 G2Labs Grzegorz Grzęda
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+//----------------------------------------------------------------------------------------------------------------------
+#ifndef BOOT_H
+#define BOOT_H
+//----------------------------------------------------------------------------------------------------------------------
+#include <stddef.h>
+#include <stdint.h>
+//----------------------------------------------------------------------------------------------------------------------
+typedef struct {
+    const char* name;
+    uint64_t timestamp_us;
+} boot_phase_t;
+//----------------------------------------------------------------------------------------------------------------------
+void boot_mark(const char* name);
+//----------------------------------------------------------------------------------------------------------------------
+size_t boot_get_phase_count(void);
+//----------------------------------------------------------------------------------------------------------------------
+int boot_get_phase(size_t index, boot_phase_t* phase);
+//----------------------------------------------------------------------------------------------------------------------
+#endif  // BOOT_H
\ No newline at end of file
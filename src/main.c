@@ -29,34 +29,65 @@
 #include <zephyr/drivers/display.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/shell/shell.h>
+#ifdef CONFIG_OPENTHREAD_MANUAL_START
+#include <zephyr/net/openthread.h>
+#endif
+#include "boot.h"
 #include "buttons.h"
 #include "measurement.h"
+#include "power.h"
 #include "ui.h"
 //----------------------------------------------------------------------------------------------------------------------
 LOG_MODULE_REGISTER(main, LOG_LEVEL_INF);
 //----------------------------------------------------------------------------------------------------------------------
-static measurement_channel_t* sensor_channels = NULL;
-static ui_measurement_t* ui_measurements = NULL;
+SHELL_SUBCMD_SET_CREATE(psu_cmds, (psu));
+SHELL_CMD_REGISTER(psu, &psu_cmds, "USB-PD PSU commands", NULL);
+//----------------------------------------------------------------------------------------------------------------------
 static size_t sensor_channel_count = 0;
+static bool first_valid_sample_received = false;
+static const struct device* power_managed_devices[2] = {NULL};
 //----------------------------------------------------------------------------------------------------------------------
 static void buttons_activated_callback(int button_index, void* userdata) {
+    if (power_notify_activity() != POWER_MODE_ACTIVE) {
+        return;
+    }
     ui_update_button_pressed(button_index);
 }
 //----------------------------------------------------------------------------------------------------------------------
-static void measurement_callback(const measurement_channel_t* const channels, size_t channel_count, void* userdata) {
-    if (channel_count != sensor_channel_count) {
-        LOG_ERR("Channel count mismatch: expected %zu, got %zu", sensor_channel_count, channel_count);
+static void power_mode_changed_callback(power_mode_t mode, void* userdata) {
+    if (mode == POWER_MODE_LOW_POWER) {
         return;
     }
-    for (size_t i = 0; i < channel_count; i++) {
-        ui_measurements[i].voltage = channels[i].voltage;
-        ui_measurements[i].current = channels[i].current;
-        ui_measurements[i].ok = channels[i].ok;
-        ui_update_measurements(ui_measurements, channel_count);
+    ui_set_dimmed(mode == POWER_MODE_DIMMED);
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void measurement_callback(const measurement_snapshot_t* const snapshot, void* userdata) {
+    if (snapshot->channel_count != sensor_channel_count) {
+        LOG_ERR("Channel count mismatch: expected %zu, got %zu", sensor_channel_count, snapshot->channel_count);
+        return;
+    }
+    for (size_t i = 0; i < snapshot->channel_count && !first_valid_sample_received; i++) {
+        if (snapshot->channels[i].ok) {
+            first_valid_sample_received = true;
+            boot_mark("first valid sample");
+        }
+    }
+    ui_update_measurements(snapshot->channels, snapshot->channel_count);
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void replay_latest_measurement(void) {
+    uint32_t version;
+    const measurement_snapshot_t* snapshot = measurement_read_begin(&version);
+    if (!snapshot) {
+        return;
     }
+    measurement_callback(snapshot, NULL);
+    measurement_read_end(snapshot, version);
 }
 //----------------------------------------------------------------------------------------------------------------------
 int main(void) {
+    boot_mark("main");
     LOG_INF("Starting USB-PD PSU application");
 
     int err = measurement_init(measurement_callback, NULL);
@@ -70,17 +101,9 @@ int main(void) {
         LOG_ERR("No measurement channels defined");
         return -1;
     }
-    sensor_channels = calloc(sensor_channel_count, sizeof(measurement_channel_t));
-    if (!sensor_channels) {
-        LOG_ERR("Failed to allocate memory for sensor channels");
-        return -ENOMEM;
-    }
-    ui_measurements = calloc(sensor_channel_count, sizeof(ui_measurement_t));
-    if (!ui_measurements) {
-        LOG_ERR("Failed to allocate memory for UI measurements");
-        free(sensor_channels);
-        return -ENOMEM;
-    }
+    boot_mark("measurement ready");
+
+    measurement_perform();
 
     ui_config_t ui_config = {
         .measurement_channel_count = sensor_channel_count,
@@ -91,17 +114,48 @@ int main(void) {
         LOG_ERR("Failed to initialize UI: %d", err);
         return err;
     }
+    boot_mark("ui ready");
+    // Replay before the first frame is rendered, so a valid sample skips the splash screen instead of flushing it
+    replay_latest_measurement();
+    ui_loop();
+    boot_mark("first frame rendered");
 
     err = buttons_init(buttons_activated_callback, NULL);
     if (err) {
         LOG_ERR("Failed to initialize buttons: %d", err);
     }
 
+#ifdef CONFIG_OPENTHREAD_MANUAL_START
+    err = openthread_start(openthread_get_default_context());
+    if (err) {
+        LOG_ERR("Failed to start OpenThread: %d", err);
+    } else {
+        boot_mark("thread started");
+    }
+#endif
+
+    // power_init() applies the Thread poll period, so it has to run after openthread_start() which sets its own
+    power_managed_devices[0] = ui_get_pm_device();
+    power_managed_devices[1] = measurement_get_pm_device();
+    power_config_t power_config = {
+        .devices = power_managed_devices,
+        .device_count = ARRAY_SIZE(power_managed_devices),
+        .full_rate_callback = measurement_consumer_active,
+        .callback = power_mode_changed_callback,
+        .userdata = NULL,
+    };
+
+    err = power_init(power_config);
+    if (err) {
+        LOG_ERR("Failed to initialize power management: %d", err);
+    }
+
     while (1) {
         measurement_perform();
         ui_loop();
+        power_loop();
 
-        k_sleep(K_MSEC(CONFIG_USB_PD_PSU_MAIN_LOOP_DELAY_MS));
+        power_wait();
     }
 
     return 0;
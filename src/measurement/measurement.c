@@ -24,10 +24,13 @@
 //----------------------------------------------------------------------------------------------------------------------
 #include "measurement.h"
 #include <stddef.h>
-#include <stdlib.h>
 #include <zephyr/drivers/sensor.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/pm/device.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/barrier.h>
+#include <zephyr/sys/util.h>
 //----------------------------------------------------------------------------------------------------------------------
 LOG_MODULE_REGISTER(measurement, LOG_LEVEL_INF);
 //----------------------------------------------------------------------------------------------------------------------
@@ -38,21 +41,96 @@ static const struct device* const sensors[] = {
 };
 //----------------------------------------------------------------------------------------------------------------------
 #define MEASUREMENT_CHANNEL_COUNT (ARRAY_SIZE(sensors))
+BUILD_ASSERT(MEASUREMENT_CHANNEL_COUNT <= MEASUREMENT_MAX_CHANNEL_COUNT, "Too many measurement channels");
+//----------------------------------------------------------------------------------------------------------------------
+typedef struct {
+    measurement_snapshot_t snapshot;
+    atomic_t version;
+} measurement_buffer_t;
 //----------------------------------------------------------------------------------------------------------------------
-static measurement_channel_t* channels = NULL;
 static measurement_callback_t measurement_callback = NULL;
 static void* measurement_userdata = NULL;
+static int64_t measurement_last_sample_ms = 0;
+static uint32_t measurement_period_ms = CONFIG_USB_PD_PSU_MEASUREMENT_PERIOD_MS;
+static measurement_buffer_t measurement_buffers[2] = {0};
+static size_t measurement_write_index = 0;
+static uint32_t measurement_sequence = 0;
+static atomic_t measurement_published_index = ATOMIC_INIT(-1);
+static atomic_t measurement_published_sequence = ATOMIC_INIT(0);
+static atomic_t measurement_reads = ATOMIC_INIT(0);
+static atomic_t measurement_torn_reads = ATOMIC_INIT(0);
+static atomic_t measurement_read_retries = ATOMIC_INIT(0);
+static atomic_t measurement_consumer_ms = ATOMIC_INIT(0);
+//----------------------------------------------------------------------------------------------------------------------
+static K_MUTEX_DEFINE(measurement_wait_mutex);
+static K_CONDVAR_DEFINE(measurement_wait_condvar);
+//----------------------------------------------------------------------------------------------------------------------
+static void clear_channel(measurement_channel_t* channel) {
+    channel->voltage = 0.0;
+    channel->current = 0.0;
+    channel->power = 0.0;
+    channel->ok = false;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int measurement_pm_action(const struct device* dev, enum pm_device_action action) {
+    switch (action) {
+        case PM_DEVICE_ACTION_SUSPEND:
+            measurement_period_ms = CONFIG_USB_PD_PSU_MEASUREMENT_IDLE_PERIOD_MS;
+            LOG_INF("Measurement rate reduced to every %u ms", measurement_period_ms);
+            return 0;
+        case PM_DEVICE_ACTION_RESUME:
+            measurement_period_ms = CONFIG_USB_PD_PSU_MEASUREMENT_PERIOD_MS;
+            measurement_last_sample_ms = 0;
+            LOG_INF("Measurement rate restored to every %u ms", measurement_period_ms);
+            return 0;
+        default:
+            return -ENOTSUP;
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int measurement_device_init(const struct device* dev) {
+    return 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+PM_DEVICE_DEFINE(measurement_pm, measurement_pm_action);
+DEVICE_DEFINE(measurement_pm,
+              "measurement",
+              measurement_device_init,
+              PM_DEVICE_GET(measurement_pm),
+              NULL,
+              NULL,
+              APPLICATION,
+              CONFIG_APPLICATION_INIT_PRIORITY,
+              NULL);
 //----------------------------------------------------------------------------------------------------------------------
 void measurement_perform(void) {
+    if (!measurement_callback) {
+        return;
+    }
+    int64_t now_ms = k_uptime_get();
+    uint32_t period_ms = measurement_period_ms;
+    if (measurement_consumer_active()) {
+        period_ms = CONFIG_USB_PD_PSU_MEASUREMENT_PERIOD_MS;
+    }
+    if (measurement_last_sample_ms && (now_ms - measurement_last_sample_ms) < period_ms) {
+        return;
+    }
+    measurement_last_sample_ms = now_ms;
+
+    measurement_buffer_t* buffer = &measurement_buffers[measurement_write_index];
+    measurement_channel_t* channels = buffer->snapshot.channels;
+    atomic_inc(&buffer->version);
+    barrier_dmem_fence_full();
+
     for (size_t i = 0; i < MEASUREMENT_CHANNEL_COUNT; i++) {
         if (!device_is_ready(sensors[i])) {
             LOG_ERR("Sensor %s is not ready", sensors[i]->name);
-            channels[i].ok = false;
+            clear_channel(&channels[i]);
             continue;
         }
         if (sensor_sample_fetch(sensors[i]) < 0) {
             LOG_ERR("Failed to fetch sample from %s", sensors[i]->name);
-            channels[i].ok = false;
+            clear_channel(&channels[i]);
             continue;
         }
 
@@ -61,7 +139,7 @@ void measurement_perform(void) {
             sensor_channel_get(sensors[i], SENSOR_CHAN_CURRENT, &current) < 0 ||
             sensor_channel_get(sensors[i], SENSOR_CHAN_POWER, &power) < 0) {
             LOG_ERR("Failed to get channel data from %s", sensors[i]->name);
-            channels[i].ok = false;
+            clear_channel(&channels[i]);
             continue;
         }
         channels[i].voltage = sensor_value_to_double(&voltage);
@@ -69,10 +147,21 @@ void measurement_perform(void) {
         channels[i].power = sensor_value_to_double(&power);
         channels[i].ok = true;
     }
-    if (!measurement_callback) {
-        return;
-    }
-    measurement_callback((const measurement_channel_t* const)channels, MEASUREMENT_CHANNEL_COUNT, measurement_userdata);
+    buffer->snapshot.sequence = ++measurement_sequence;
+    buffer->snapshot.timestamp_ms = now_ms;
+    buffer->snapshot.channel_count = MEASUREMENT_CHANNEL_COUNT;
+
+    barrier_dmem_fence_full();
+    atomic_inc(&buffer->version);
+    atomic_set(&measurement_published_index, measurement_write_index);
+    atomic_set(&measurement_published_sequence, measurement_sequence);
+    measurement_write_index ^= 1;
+
+    k_mutex_lock(&measurement_wait_mutex, K_FOREVER);
+    k_condvar_broadcast(&measurement_wait_condvar);
+    k_mutex_unlock(&measurement_wait_mutex);
+
+    measurement_callback(&buffer->snapshot, measurement_userdata);
 }
 //----------------------------------------------------------------------------------------------------------------------
 int measurement_init(measurement_callback_t callback, void* userdata) {
@@ -98,14 +187,8 @@ int measurement_init(measurement_callback_t callback, void* userdata) {
         return -1;
     }
 
-    channels = calloc(MEASUREMENT_CHANNEL_COUNT, sizeof(measurement_channel_t));
-    if (!channels) {
-        LOG_ERR("Failed to allocate memory for measurement channels");
-        return -1;
-    }
-
-    measurement_callback = callback;
     measurement_userdata = userdata;
+    measurement_callback = callback;
 
     return 0;
 }
@@ -114,3 +197,78 @@ size_t measurement_get_channel_count(void) {
     return MEASUREMENT_CHANNEL_COUNT;
 }
 //----------------------------------------------------------------------------------------------------------------------
+const struct device* measurement_get_pm_device(void) {
+    return DEVICE_GET(measurement_pm);
+}
+//----------------------------------------------------------------------------------------------------------------------
+const measurement_snapshot_t* measurement_read_begin(uint32_t* version) {
+    if (!version) {
+        return NULL;
+    }
+    while (true) {
+        atomic_val_t index = atomic_get(&measurement_published_index);
+        if (index < 0) {
+            return NULL;
+        }
+        measurement_buffer_t* buffer = &measurement_buffers[index];
+        *version = atomic_get(&buffer->version);
+        if (!(*version & 1)) {
+            barrier_dmem_fence_full();
+            return &buffer->snapshot;
+        }
+        atomic_inc(&measurement_read_retries);
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool measurement_read_end(const measurement_snapshot_t* snapshot, uint32_t version) {
+    if (!snapshot) {
+        return false;
+    }
+    const measurement_buffer_t* buffer = CONTAINER_OF(snapshot, measurement_buffer_t, snapshot);
+    barrier_dmem_fence_full();
+    atomic_inc(&measurement_reads);
+    if ((uint32_t)atomic_get(&buffer->version) != version) {
+        atomic_inc(&measurement_torn_reads);
+        return false;
+    }
+    return true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void measurement_notify_consumer(void) {
+    atomic_set(&measurement_consumer_ms, (atomic_val_t)MAX(k_uptime_get_32(), 1));
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool measurement_consumer_active(void) {
+    uint32_t consumer_ms = (uint32_t)atomic_get(&measurement_consumer_ms);
+    return consumer_ms && (k_uptime_get_32() - consumer_ms) < CONFIG_USB_PD_PSU_MEASUREMENT_CONSUMER_HOLD_MS;
+}
+//----------------------------------------------------------------------------------------------------------------------
+uint32_t measurement_get_sequence(void) {
+    return atomic_get(&measurement_published_sequence);
+}
+//----------------------------------------------------------------------------------------------------------------------
+int measurement_wait_for_sequence(uint32_t sequence, uint32_t timeout_ms) {
+    k_timepoint_t end = sys_timepoint_calc(K_MSEC(timeout_ms));
+    int err = 0;
+    k_mutex_lock(&measurement_wait_mutex, K_FOREVER);
+    while (measurement_get_sequence() == sequence) {
+        if (k_condvar_wait(&measurement_wait_condvar, &measurement_wait_mutex, sys_timepoint_timeout(end))) {
+            err = -EAGAIN;
+            break;
+        }
+    }
+    k_mutex_unlock(&measurement_wait_mutex);
+    return err;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void measurement_get_read_stats(measurement_read_stats_t* stats) {
+    if (!stats) {
+        return;
+    }
+    stats->reads = atomic_get(&measurement_reads);
+    stats->torn_reads = atomic_get(&measurement_torn_reads);
+    stats->read_retries = atomic_get(&measurement_read_retries);
+    stats->buffer_count = ARRAY_SIZE(measurement_buffers);
+    stats->buffer_size = sizeof(measurement_buffer_t);
+}
+//----------------------------------------------------------------------------------------------------------------------
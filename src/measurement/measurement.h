@@ -27,6 +27,10 @@
 //----------------------------------------------------------------------------------------------------------------------
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <zephyr/device.h>
+//----------------------------------------------------------------------------------------------------------------------
+#define MEASUREMENT_MAX_CHANNEL_COUNT 3
 //----------------------------------------------------------------------------------------------------------------------
 typedef struct measurement_channel {
     double voltage;
@@ -35,9 +39,22 @@ typedef struct measurement_channel {
     bool ok;
 } measurement_channel_t;
 //----------------------------------------------------------------------------------------------------------------------
-typedef void (*measurement_callback_t)(const measurement_channel_t* const channels,
-                                       size_t channel_count,
-                                       void* userdata);
+typedef struct measurement_snapshot {
+    uint32_t sequence;
+    int64_t timestamp_ms;
+    size_t channel_count;
+    measurement_channel_t channels[MEASUREMENT_MAX_CHANNEL_COUNT];
+} measurement_snapshot_t;
+//----------------------------------------------------------------------------------------------------------------------
+typedef struct measurement_read_stats {
+    uint32_t reads;
+    uint32_t torn_reads;
+    uint32_t read_retries;
+    size_t buffer_count;
+    size_t buffer_size;
+} measurement_read_stats_t;
+//----------------------------------------------------------------------------------------------------------------------
+typedef void (*measurement_callback_t)(const measurement_snapshot_t* const snapshot, void* userdata);
 //----------------------------------------------------------------------------------------------------------------------
 int measurement_init(measurement_callback_t callback, void* userdata);
 //----------------------------------------------------------------------------------------------------------------------
@@ -45,4 +62,20 @@ void measurement_perform(void);
 //----------------------------------------------------------------------------------------------------------------------
 size_t measurement_get_channel_count(void);
 //----------------------------------------------------------------------------------------------------------------------
+const struct device* measurement_get_pm_device(void);
+//----------------------------------------------------------------------------------------------------------------------
+const measurement_snapshot_t* measurement_read_begin(uint32_t* version);
+//----------------------------------------------------------------------------------------------------------------------
+bool measurement_read_end(const measurement_snapshot_t* snapshot, uint32_t version);
+//----------------------------------------------------------------------------------------------------------------------
+void measurement_notify_consumer(void);
+//----------------------------------------------------------------------------------------------------------------------
+bool measurement_consumer_active(void);
+//----------------------------------------------------------------------------------------------------------------------
+uint32_t measurement_get_sequence(void);
+//----------------------------------------------------------------------------------------------------------------------
+int measurement_wait_for_sequence(uint32_t sequence, uint32_t timeout_ms);
+//----------------------------------------------------------------------------------------------------------------------
+void measurement_get_read_stats(measurement_read_stats_t* stats);
+//----------------------------------------------------------------------------------------------------------------------
 #endif  // MEASUREMENT_H
\ No newline at end of file
@@ -0,0 +1,188 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 G2Labs Grzegorz Grzęda
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+//----------------------------------------------------------------------------------------------------------------------
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/sys/printk.h>
+#include "measurement.h"
+//----------------------------------------------------------------------------------------------------------------------
+#define MEASUREMENT_SHELL_MAX_LINKS 2
+#define MEASUREMENT_SHELL_DEFAULT_WAIT_TIMEOUT_MS 5000
+#define MEASUREMENT_SHELL_MAX_READ_ATTEMPTS 4
+#define MEASUREMENT_SHELL_LINE_SIZE 160
+//----------------------------------------------------------------------------------------------------------------------
+typedef struct {
+    const struct shell* sh;
+    uint32_t total_queries;
+    uint32_t window_queries;
+    int64_t window_start_ms;
+} measurement_shell_link_t;
+//----------------------------------------------------------------------------------------------------------------------
+static measurement_shell_link_t measurement_shell_links[MEASUREMENT_SHELL_MAX_LINKS] = {0};
+static measurement_shell_link_t measurement_shell_other_links = {0};
+static struct k_spinlock measurement_shell_lock;
+//----------------------------------------------------------------------------------------------------------------------
+static void count_query(const struct shell* sh) {
+    measurement_notify_consumer();
+
+    k_spinlock_key_t key = k_spin_lock(&measurement_shell_lock);
+    measurement_shell_link_t* link = &measurement_shell_other_links;
+    for (size_t i = 0; i < MEASUREMENT_SHELL_MAX_LINKS; i++) {
+        if (!measurement_shell_links[i].sh) {
+            measurement_shell_links[i].sh = sh;
+            measurement_shell_links[i].window_start_ms = k_uptime_get();
+        }
+        if (measurement_shell_links[i].sh == sh) {
+            link = &measurement_shell_links[i];
+            break;
+        }
+    }
+    if (!link->window_start_ms) {
+        link->window_start_ms = k_uptime_get();
+    }
+    link->total_queries++;
+    link->window_queries++;
+    k_spin_unlock(&measurement_shell_lock, key);
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void print_link_stats(const struct shell* sh, const char* name, const measurement_shell_link_t* link,
+                             int64_t now_ms) {
+    int64_t window_ms = now_ms - link->window_start_ms;
+    uint64_t rate_milli = window_ms > 0 ? ((uint64_t)link->window_queries * 1000000) / window_ms : 0;
+    shell_print(sh, "%-16s %10u %10u %12lld %6llu.%03llu", name, link->total_queries, link->window_queries, window_ms,
+                rate_milli / 1000, rate_milli % 1000);
+}
+//----------------------------------------------------------------------------------------------------------------------
+static long to_milli(double value) {
+    return lround(value * 1000.0);
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int format_snapshot(char* line, size_t line_size) {
+    for (size_t attempt = 0; attempt < MEASUREMENT_SHELL_MAX_READ_ATTEMPTS; attempt++) {
+        uint32_t version;
+        const measurement_snapshot_t* snapshot = measurement_read_begin(&version);
+        if (!snapshot) {
+            return -ENODATA;
+        }
+        size_t length = snprintk(line, line_size, "seq=%u ts=%lld", snapshot->sequence, snapshot->timestamp_ms);
+        for (size_t i = 0; i < MIN(snapshot->channel_count, MEASUREMENT_MAX_CHANNEL_COUNT) && length < line_size; i++) {
+            const measurement_channel_t* channel = &snapshot->channels[i];
+            length += snprintk(line + length, line_size - length, " %zu:%ld,%ld,%ld,%s", i, to_milli(channel->voltage),
+                               to_milli(channel->current), to_milli(channel->power), channel->ok ? "ok" : "err");
+        }
+        if (measurement_read_end(snapshot, version)) {
+            return 0;
+        }
+    }
+    return -EBUSY;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int print_snapshot(const struct shell* sh) {
+    char line[MEASUREMENT_SHELL_LINE_SIZE];
+    int err = format_snapshot(line, sizeof(line));
+    if (err) {
+        shell_error(sh, "No consistent measurement available: %d", err);
+        return err;
+    }
+    shell_print(sh, "%s", line);
+    return 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int cmd_meas_all(const struct shell* sh, size_t argc, char** argv) {
+    count_query(sh);
+    return print_snapshot(sh);
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int cmd_meas_wait(const struct shell* sh, size_t argc, char** argv) {
+    count_query(sh);
+    uint32_t timeout_ms = MEASUREMENT_SHELL_DEFAULT_WAIT_TIMEOUT_MS;
+    if (argc > 1) {
+        char* end = NULL;
+        unsigned long value = strtoul(argv[1], &end, 10);
+        if (!end || *end != '\0') {
+            shell_error(sh, "Invalid timeout: %s", argv[1]);
+            return -EINVAL;
+        }
+        timeout_ms = value;
+    }
+
+    int err = measurement_wait_for_sequence(measurement_get_sequence(), timeout_ms);
+    if (err) {
+        shell_error(sh, "No fresh measurement within %u ms", timeout_ms);
+        return err;
+    }
+    return print_snapshot(sh);
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int cmd_meas_stats(const struct shell* sh, size_t argc, char** argv) {
+    measurement_shell_link_t links[MEASUREMENT_SHELL_MAX_LINKS];
+    measurement_shell_link_t other_links;
+    int64_t now_ms = k_uptime_get();
+
+    k_spinlock_key_t key = k_spin_lock(&measurement_shell_lock);
+    memcpy(links, measurement_shell_links, sizeof(links));
+    other_links = measurement_shell_other_links;
+    for (size_t i = 0; i < MEASUREMENT_SHELL_MAX_LINKS; i++) {
+        measurement_shell_links[i].window_queries = 0;
+        measurement_shell_links[i].window_start_ms = now_ms;
+    }
+    measurement_shell_other_links.window_queries = 0;
+    measurement_shell_other_links.window_start_ms = now_ms;
+    k_spin_unlock(&measurement_shell_lock, key);
+
+    shell_print(sh, "%-16s %10s %10s %12s %10s", "link", "queries", "in window", "window [ms]", "q/s");
+    for (size_t i = 0; i < MEASUREMENT_SHELL_MAX_LINKS; i++) {
+        if (!links[i].sh) {
+            continue;
+        }
+        print_link_stats(sh, links[i].sh->name, &links[i], now_ms);
+    }
+    if (other_links.total_queries) {
+        print_link_stats(sh, "(other links)", &other_links, now_ms);
+    }
+
+    measurement_read_stats_t read_stats;
+    measurement_get_read_stats(&read_stats);
+    shell_print(sh, "snapshot reads: %u, torn reads detected: %u, retries on buffer being written: %u",
+                read_stats.reads, read_stats.torn_reads, read_stats.read_retries);
+    shell_print(sh, "snapshot buffers: %zu x %zu bytes", read_stats.buffer_count, read_stats.buffer_size);
+    return 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+SHELL_STATIC_SUBCMD_SET_CREATE(
+    meas_cmds,
+    SHELL_CMD(all,
+              NULL,
+              "Print all channels from the latest sample set as: seq=<n> ts=<ms> <ch>:<mV>,<mA>,<mW>,<ok|err> ...",
+              cmd_meas_all),
+    SHELL_CMD_ARG(wait, NULL, "Wait for the next sample set and print it like 'all'. Usage: wait [timeout_ms]",
+                  cmd_meas_wait, 1, 1),
+    SHELL_CMD(stats, NULL, "Show queries per second per shell link since the last call and snapshot read statistics",
+              cmd_meas_stats),
+    SHELL_SUBCMD_SET_END);
+SHELL_SUBCMD_ADD((psu), meas, &meas_cmds, "Batched measurement queries", NULL, 0, 0);
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,273 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 G2Labs Grzegorz Grzęda
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+//----------------------------------------------------------------------------------------------------------------------
+#include "power.h"
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/pm/device.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/atomic.h>
+#ifdef CONFIG_OPENTHREAD
+#include <openthread/link.h>
+#include <zephyr/net/openthread.h>
+#endif
+//----------------------------------------------------------------------------------------------------------------------
+BUILD_ASSERT(CONFIG_USB_PD_PSU_POWER_DIM_TIMEOUT_MS < CONFIG_USB_PD_PSU_POWER_LOW_POWER_TIMEOUT_MS,
+             "Display dim timeout must be shorter than the low-power timeout");
+//----------------------------------------------------------------------------------------------------------------------
+typedef struct {
+    int64_t uptime_ms;
+    uint64_t cpu_active_cycles;
+    uint64_t cpu_total_cycles;
+    uint32_t radio_frames;
+} power_sample_t;
+//----------------------------------------------------------------------------------------------------------------------
+LOG_MODULE_REGISTER(power, LOG_LEVEL_INF);
+//----------------------------------------------------------------------------------------------------------------------
+static power_config_t power_config = {0};
+static bool power_initialized = false;
+static atomic_t power_mode = ATOMIC_INIT(POWER_MODE_ACTIVE);
+static atomic_t power_last_activity_ms = ATOMIC_INIT(0);
+static atomic_t power_sleep_requested = ATOMIC_INIT(0);
+static power_mode_stats_t power_stats[POWER_MODE_COUNT] = {0};
+static power_sample_t power_last_sample = {0};
+//----------------------------------------------------------------------------------------------------------------------
+static K_SEM_DEFINE(power_wake_sem, 0, 1);
+static K_MUTEX_DEFINE(power_stats_mutex);
+//----------------------------------------------------------------------------------------------------------------------
+#ifdef CONFIG_OPENTHREAD
+static uint32_t power_get_radio_frames(void) {
+    struct openthread_context* context = openthread_get_default_context();
+    if (!context) {
+        return 0;
+    }
+    openthread_api_mutex_lock(context);
+    const otMacCounters* counters = otLinkGetCounters(openthread_get_default_instance());
+    uint32_t frames = counters->mTxTotal + counters->mRxTotal;
+    openthread_api_mutex_unlock(context);
+    return frames;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void power_set_thread_poll_period(uint32_t poll_period_ms) {
+    struct openthread_context* context = openthread_get_default_context();
+    if (!context) {
+        LOG_ERR("OpenThread context not available");
+        return;
+    }
+    openthread_api_mutex_lock(context);
+    otError error = otLinkSetPollPeriod(openthread_get_default_instance(), poll_period_ms);
+    openthread_api_mutex_unlock(context);
+    if (error != OT_ERROR_NONE) {
+        LOG_ERR("Failed to set Thread poll period to %u ms: %d", poll_period_ms, error);
+        return;
+    }
+    LOG_INF("Thread poll period set to %u ms", poll_period_ms);
+}
+#else
+static uint32_t power_get_radio_frames(void) {
+    return 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void power_set_thread_poll_period(uint32_t poll_period_ms) {}
+#endif
+//----------------------------------------------------------------------------------------------------------------------
+static void power_take_sample(power_sample_t* sample) {
+    k_thread_runtime_stats_t cpu_stats;
+    k_thread_runtime_stats_all_get(&cpu_stats);
+    sample->uptime_ms = k_uptime_get();
+    sample->cpu_active_cycles = cpu_stats.total_cycles;
+    sample->cpu_total_cycles = cpu_stats.execution_cycles;
+    sample->radio_frames = power_get_radio_frames();
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void power_account(void) {
+    power_sample_t sample;
+    power_take_sample(&sample);
+
+    power_mode_stats_t* stats = &power_stats[atomic_get(&power_mode)];
+    stats->time_ms += sample.uptime_ms - power_last_sample.uptime_ms;
+    stats->cpu_active_cycles += sample.cpu_active_cycles - power_last_sample.cpu_active_cycles;
+    stats->cpu_total_cycles += sample.cpu_total_cycles - power_last_sample.cpu_total_cycles;
+    stats->radio_frames += (uint32_t)(sample.radio_frames - power_last_sample.radio_frames);
+    stats->radio_on_us = stats->radio_frames * CONFIG_USB_PD_PSU_POWER_RADIO_FRAME_US;
+
+    power_last_sample = sample;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void power_run_device_action(enum pm_device_action action) {
+    for (size_t i = 0; i < power_config.device_count; i++) {
+        int err = pm_device_action_run(power_config.devices[i], action);
+        if (err < 0 && err != -EALREADY) {
+            LOG_ERR("Failed to run PM action %d on %s: %d", action, power_config.devices[i]->name, err);
+        }
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void power_set_mode(power_mode_t mode) {
+    power_mode_t previous_mode = atomic_get(&power_mode);
+
+    k_mutex_lock(&power_stats_mutex, K_FOREVER);
+    power_account();
+    atomic_set(&power_mode, mode);
+    k_mutex_unlock(&power_stats_mutex);
+
+    if (mode == POWER_MODE_LOW_POWER) {
+        power_run_device_action(PM_DEVICE_ACTION_SUSPEND);
+        power_set_thread_poll_period(CONFIG_USB_PD_PSU_POWER_THREAD_LOW_POWER_POLL_PERIOD_MS);
+    } else if (previous_mode == POWER_MODE_LOW_POWER) {
+        power_run_device_action(PM_DEVICE_ACTION_RESUME);
+        power_set_thread_poll_period(CONFIG_USB_PD_PSU_POWER_THREAD_POLL_PERIOD_MS);
+    }
+
+    LOG_INF("Power mode changed: %s -> %s", power_mode_to_string(previous_mode), power_mode_to_string(mode));
+
+    if (power_config.callback) {
+        power_config.callback(mode, power_config.userdata);
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+int power_init(power_config_t config) {
+    if (config.device_count > 0 && !config.devices) {
+        LOG_ERR("Device list cannot be NULL");
+        return -EINVAL;
+    }
+    for (size_t i = 0; i < config.device_count; i++) {
+        if (!device_is_ready(config.devices[i])) {
+            LOG_ERR("Device %s is not ready", config.devices[i]->name);
+            return -ENODEV;
+        }
+    }
+    power_config = config;
+
+    k_mutex_lock(&power_stats_mutex, K_FOREVER);
+    power_take_sample(&power_last_sample);
+    k_mutex_unlock(&power_stats_mutex);
+
+    atomic_set(&power_last_activity_ms, (atomic_val_t)k_uptime_get_32());
+    power_set_thread_poll_period(CONFIG_USB_PD_PSU_POWER_THREAD_POLL_PERIOD_MS);
+    power_initialized = true;
+
+    return 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+power_mode_t power_notify_activity(void) {
+    atomic_set(&power_last_activity_ms, (atomic_val_t)k_uptime_get_32());
+    atomic_clear(&power_sleep_requested);
+    k_sem_give(&power_wake_sem);
+    return atomic_get(&power_mode);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void power_loop(void) {
+    if (!power_initialized) {
+        return;
+    }
+    uint32_t idle_ms = k_uptime_get_32() - (uint32_t)atomic_get(&power_last_activity_ms);
+
+    power_mode_t mode = POWER_MODE_ACTIVE;
+    if (atomic_get(&power_sleep_requested) || idle_ms >= CONFIG_USB_PD_PSU_POWER_LOW_POWER_TIMEOUT_MS) {
+        mode = POWER_MODE_LOW_POWER;
+    } else if (idle_ms >= CONFIG_USB_PD_PSU_POWER_DIM_TIMEOUT_MS) {
+        mode = POWER_MODE_DIMMED;
+    }
+
+    if (mode != atomic_get(&power_mode)) {
+        power_set_mode(mode);
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+void power_wait(void) {
+    uint32_t delay_ms = CONFIG_USB_PD_PSU_MAIN_LOOP_DELAY_MS;
+    bool full_rate = power_config.full_rate_callback && power_config.full_rate_callback();
+    if (atomic_get(&power_mode) == POWER_MODE_LOW_POWER && !full_rate) {
+        delay_ms = CONFIG_USB_PD_PSU_POWER_LOW_POWER_LOOP_DELAY_MS;
+    }
+    k_sem_take(&power_wake_sem, K_MSEC(delay_ms));
+}
+//----------------------------------------------------------------------------------------------------------------------
+power_mode_t power_get_mode(void) {
+    return atomic_get(&power_mode);
+}
+//----------------------------------------------------------------------------------------------------------------------
+int power_get_stats(power_mode_t mode, power_mode_stats_t* stats) {
+    if (mode >= POWER_MODE_COUNT || !stats) {
+        return -EINVAL;
+    }
+    if (!power_initialized) {
+        return -EAGAIN;
+    }
+    k_mutex_lock(&power_stats_mutex, K_FOREVER);
+    power_account();
+    *stats = power_stats[mode];
+    k_mutex_unlock(&power_stats_mutex);
+    return 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+const char* power_mode_to_string(power_mode_t mode) {
+    switch (mode) {
+        case POWER_MODE_ACTIVE:
+            return "active";
+        case POWER_MODE_DIMMED:
+            return "dimmed";
+        case POWER_MODE_LOW_POWER:
+            return "low-power";
+        default:
+            return "unknown";
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int cmd_power_stats(const struct shell* sh, size_t argc, char** argv) {
+    shell_print(sh, "current mode: %s", power_mode_to_string(power_get_mode()));
+    shell_print(sh, "%-10s %12s %12s %8s %12s %8s", "mode", "time [ms]", "cpu [ms]", "cpu [%]", "radio [ms]",
+                "radio [%]");
+    for (power_mode_t mode = POWER_MODE_ACTIVE; mode < POWER_MODE_COUNT; mode++) {
+        power_mode_stats_t stats;
+        int err = power_get_stats(mode, &stats);
+        if (err) {
+            shell_error(sh, "Failed to get power stats: %d", err);
+            return err;
+        }
+        uint64_t cpu_permille = stats.cpu_total_cycles ? (stats.cpu_active_cycles * 1000) / stats.cpu_total_cycles : 0;
+        uint64_t radio_permille = stats.time_ms ? stats.radio_on_us / stats.time_ms : 0;
+        shell_print(sh, "%-10s %12lld %12llu %6llu.%llu %12llu %6llu.%llu", power_mode_to_string(mode), stats.time_ms,
+                    k_cyc_to_ms_floor64(stats.cpu_active_cycles), cpu_permille / 10, cpu_permille % 10,
+                    stats.radio_on_us / 1000, radio_permille / 10, radio_permille % 10);
+    }
+    return 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int cmd_power_sleep(const struct shell* sh, size_t argc, char** argv) {
+    atomic_set(&power_sleep_requested, 1);
+    k_sem_give(&power_wake_sem);
+    shell_print(sh, "Entering low-power mode until the next button press");
+    return 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+SHELL_STATIC_SUBCMD_SET_CREATE(power_cmds,
+                               SHELL_CMD(stats, NULL, "Show time, CPU active time and radio-on estimate per mode",
+                                         cmd_power_stats),
+                               SHELL_CMD(sleep, NULL, "Enter the low-power mode until the next button press",
+                                         cmd_power_sleep),
+                               SHELL_SUBCMD_SET_END);
+SHELL_SUBCMD_ADD((psu), power, &power_cmds, "Power management", NULL, 0, 0);
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,73 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 G2Labs Grzegorz Grzęda
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+//----------------------------------------------------------------------------------------------------------------------
+#ifndef POWER_H
+#define POWER_H
+//----------------------------------------------------------------------------------------------------------------------
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/device.h>
+//----------------------------------------------------------------------------------------------------------------------
+typedef enum {
+    POWER_MODE_ACTIVE = 0,
+    POWER_MODE_DIMMED,
+    POWER_MODE_LOW_POWER,
+    POWER_MODE_COUNT,
+} power_mode_t;
+//----------------------------------------------------------------------------------------------------------------------
+typedef struct {
+    int64_t time_ms;
+    uint64_t cpu_active_cycles;
+    uint64_t cpu_total_cycles;
+    uint64_t radio_frames;
+    uint64_t radio_on_us;
+} power_mode_stats_t;
+//----------------------------------------------------------------------------------------------------------------------
+typedef void (*power_mode_changed_callback_t)(power_mode_t mode, void* userdata);
+//----------------------------------------------------------------------------------------------------------------------
+typedef bool (*power_full_rate_callback_t)(void);
+//----------------------------------------------------------------------------------------------------------------------
+typedef struct {
+    const struct device* const* devices;
+    size_t device_count;
+    power_full_rate_callback_t full_rate_callback;
+    power_mode_changed_callback_t callback;
+    void* userdata;
+} power_config_t;
+//----------------------------------------------------------------------------------------------------------------------
+int power_init(power_config_t config);
+//----------------------------------------------------------------------------------------------------------------------
+power_mode_t power_notify_activity(void);
+//----------------------------------------------------------------------------------------------------------------------
+void power_loop(void);
+//----------------------------------------------------------------------------------------------------------------------
+void power_wait(void);
+//----------------------------------------------------------------------------------------------------------------------
+power_mode_t power_get_mode(void);
+//----------------------------------------------------------------------------------------------------------------------
+int power_get_stats(power_mode_t mode, power_mode_stats_t* stats);
+//----------------------------------------------------------------------------------------------------------------------
+const char* power_mode_to_string(power_mode_t mode);
+//----------------------------------------------------------------------------------------------------------------------
+#endif  // POWER_H
\ No newline at end of file
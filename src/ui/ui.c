@@ -29,7 +29,10 @@
 #include <stdlib.h>
 #include <zephyr/drivers/display.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/pm/device.h>
+#include <zephyr/sys/atomic.h>
 #include "app_version.h"
+#include "boot.h"
 #include "zephyr/version.h"
 //----------------------------------------------------------------------------------------------------------------------
 typedef struct {
@@ -46,13 +49,57 @@ static ui_channel_labels_t* measurement_channel_labels = NULL;
 static ui_config_t ui_config = {0};
 static lv_obj_t* settings_screen = NULL;
 static lv_obj_t* info_screen = NULL;
+static lv_timer_t* splash_timer = NULL;
+static const struct device* display_dev = NULL;
+static atomic_t ui_suspended = ATOMIC_INIT(0);
+static atomic_t ui_invalidate_pending = ATOMIC_INIT(0);
+static atomic_t ui_requested_screen = ATOMIC_INIT(-1);
 //----------------------------------------------------------------------------------------------------------------------
 LOG_MODULE_REGISTER(ui, LOG_LEVEL_INF);
 //----------------------------------------------------------------------------------------------------------------------
+static int ui_pm_action(const struct device* dev, enum pm_device_action action) {
+    if (!display_dev) {
+        return -ENODEV;
+    }
+    switch (action) {
+        case PM_DEVICE_ACTION_SUSPEND:
+            atomic_set(&ui_suspended, 1);
+            display_blanking_on(display_dev);
+            LOG_INF("Display blanked");
+            return 0;
+        case PM_DEVICE_ACTION_RESUME:
+            display_set_contrast(display_dev, CONFIG_USB_PD_PSU_UI_CONTRAST);
+            display_blanking_off(display_dev);
+            atomic_set(&ui_invalidate_pending, 1);
+            atomic_clear(&ui_suspended);
+            LOG_INF("Display unblanked");
+            return 0;
+        default:
+            return -ENOTSUP;
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+static int ui_device_init(const struct device* dev) {
+    return 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+PM_DEVICE_DEFINE(ui_pm, ui_pm_action);
+DEVICE_DEFINE(ui_pm,
+              "ui",
+              ui_device_init,
+              PM_DEVICE_GET(ui_pm),
+              NULL,
+              NULL,
+              APPLICATION,
+              CONFIG_APPLICATION_INIT_PRIORITY,
+              NULL);
+//----------------------------------------------------------------------------------------------------------------------
 static void screen_to_load_after_timeout_cb(lv_timer_t* timer) {
     lv_obj_t* screen_to_load = (lv_obj_t*)lv_timer_get_user_data(timer);
     lv_screen_load(screen_to_load);
     lv_timer_delete(timer);
+    splash_timer = NULL;
+    LOG_WRN("No valid measurement before splash screen timeout");
 }
 //----------------------------------------------------------------------------------------------------------------------
 static void set_default_style_for(lv_obj_t* obj) {
@@ -78,12 +125,80 @@ static void render_splash_screen(void) {
     lv_obj_center(logo);
 
     lv_screen_load(splash_screen);
-    lv_timer_create(screen_to_load_after_timeout_cb, CONFIG_USB_PD_PSU_UI_SPLASH_SCREEN_TIMEOUT_MS, measurement_screen);
+    splash_timer = lv_timer_create(screen_to_load_after_timeout_cb, CONFIG_USB_PD_PSU_UI_SPLASH_SCREEN_TIMEOUT_MS,
+                                   measurement_screen);
+}
+//----------------------------------------------------------------------------------------------------------------------
+static bool dismiss_splash_screen(void) {
+    if (!splash_timer) {
+        return false;
+    }
+    lv_timer_delete(splash_timer);
+    splash_timer = NULL;
+    lv_screen_load(measurement_screen);
+    return true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static lv_obj_t* create_settings_screen(void) {
+    lv_obj_t* screen = lv_obj_create(NULL);
+    set_default_style_for(screen);
+    lv_obj_t* settings_title_label = lv_label_create(screen);
+    lv_label_set_text(settings_title_label, "Settings");
+    lv_obj_align(settings_title_label, LV_ALIGN_TOP_MID, 0, 0);
+    lv_obj_set_style_text_font(settings_title_label, &lv_font_montserrat_14, 0);
+    return screen;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static lv_obj_t* create_info_screen(void) {
+    lv_obj_t* screen = lv_obj_create(NULL);
+    set_default_style_for(screen);
+    lv_obj_t* info_title_label = lv_label_create(screen);
+    lv_label_set_text(info_title_label, "Info");
+    lv_obj_align(info_title_label, LV_ALIGN_TOP_MID, 0, 0);
+    lv_obj_set_style_text_font(info_title_label, &lv_font_montserrat_14, 0);
+
+    lv_obj_t* app_version_label = lv_label_create(screen);
+    char version_text[64];
+    sprintf(version_text, "App: %s", APP_VERSION_EXTENDED_STRING);
+    lv_label_set_text(app_version_label, version_text);
+    lv_obj_align(app_version_label, LV_ALIGN_TOP_LEFT, 0, 15);
+    lv_obj_set_style_text_font(app_version_label, &lv_font_montserrat_12, 0);
+
+    sprintf(version_text, "Zephyr: %s", KERNEL_VERSION_EXTENDED_STRING);
+    lv_obj_t* zephyr_version_label = lv_label_create(screen);
+    lv_label_set_text(zephyr_version_label, version_text);
+    lv_obj_align(zephyr_version_label, LV_ALIGN_TOP_LEFT, 0, 30);
+    lv_obj_set_style_text_font(zephyr_version_label, &lv_font_montserrat_12, 0);
+
+    lv_obj_t* lvgl_version_label = lv_label_create(screen);
+    sprintf(version_text, "LVGL: %d.%d.%d %s", LVGL_VERSION_MAJOR, LVGL_VERSION_MINOR, LVGL_VERSION_PATCH,
+            LVGL_VERSION_INFO);
+    lv_label_set_text(lvgl_version_label, version_text);
+    lv_obj_align(lvgl_version_label, LV_ALIGN_TOP_LEFT, 0, 45);
+    lv_obj_set_style_text_font(lvgl_version_label, &lv_font_montserrat_12, 0);
+    return screen;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static void load_requested_screen(int button_index) {
+    if (button_index == 0) {
+        dismiss_splash_screen();
+        lv_screen_load(measurement_screen);
+    } else if (button_index == 1) {
+        if (!settings_screen) {
+            settings_screen = create_settings_screen();
+        }
+        lv_screen_load(settings_screen);
+    } else if (button_index == 2) {
+        if (!info_screen) {
+            info_screen = create_info_screen();
+        }
+        lv_screen_load(info_screen);
+    }
 }
 //----------------------------------------------------------------------------------------------------------------------
 int ui_init(ui_config_t config) {
-    const struct device* display_dev = DEVICE_DT_GET(DT_CHOSEN(zephyr_display));
-    if (!device_is_ready(display_dev)) {
+    const struct device* dev = DEVICE_DT_GET(DT_CHOSEN(zephyr_display));
+    if (!device_is_ready(dev)) {
         LOG_ERR("Display device not ready, aborting");
         return -1;
     }
@@ -126,82 +241,77 @@ int ui_init(ui_config_t config) {
         lv_obj_set_style_text_font(measurement_channel_labels[i].current_label, &lv_font_montserrat_12, 0);
     }
 
-    settings_screen = lv_obj_create(NULL);
-    set_default_style_for(settings_screen);
-    lv_obj_t* settings_title_label = lv_label_create(settings_screen);
-    lv_label_set_text(settings_title_label, "Settings");
-    lv_obj_align(settings_title_label, LV_ALIGN_TOP_MID, 0, 0);
-    lv_obj_set_style_text_font(settings_title_label, &lv_font_montserrat_14, 0);
-
-    info_screen = lv_obj_create(NULL);
-    set_default_style_for(info_screen);
-    lv_obj_t* info_title_label = lv_label_create(info_screen);
-    lv_label_set_text(info_title_label, "Info");
-    lv_obj_align(info_title_label, LV_ALIGN_TOP_MID, 0, 0);
-    lv_obj_set_style_text_font(info_title_label, &lv_font_montserrat_14, 0);
-
-    lv_obj_t* app_version_label = lv_label_create(info_screen);
-    char version_text[64];
-    sprintf(version_text, "App: %s", APP_VERSION_EXTENDED_STRING);
-    lv_label_set_text(app_version_label, version_text);
-    lv_obj_align(app_version_label, LV_ALIGN_TOP_LEFT, 0, 15);
-    lv_obj_set_style_text_font(app_version_label, &lv_font_montserrat_12, 0);
-
-    sprintf(version_text, "Zephyr: %s", KERNEL_VERSION_EXTENDED_STRING);
-    lv_obj_t* zephyr_version_label = lv_label_create(info_screen);
-    lv_label_set_text(zephyr_version_label, version_text);
-    lv_obj_align(zephyr_version_label, LV_ALIGN_TOP_LEFT, 0, 30);
-    lv_obj_set_style_text_font(zephyr_version_label, &lv_font_montserrat_12, 0);
-
-    lv_obj_t* lvgl_version_label = lv_label_create(info_screen);
-    sprintf(version_text, "LVGL: %d.%d.%d %s", LVGL_VERSION_MAJOR, LVGL_VERSION_MINOR, LVGL_VERSION_PATCH,
-            LVGL_VERSION_INFO);
-    lv_label_set_text(lvgl_version_label, version_text);
-    lv_obj_align(lvgl_version_label, LV_ALIGN_TOP_LEFT, 0, 45);
-    lv_obj_set_style_text_font(lvgl_version_label, &lv_font_montserrat_12, 0);
-
+    display_dev = dev;
     render_splash_screen();
+    display_set_contrast(display_dev, CONFIG_USB_PD_PSU_UI_CONTRAST);
     display_blanking_off(display_dev);
-    lv_timer_handler();
 
     return 0;
 }
 //----------------------------------------------------------------------------------------------------------------------
-int ui_update_measurements(ui_measurement_t* measurements, size_t channel_count) {
-    if (!measurements || channel_count == 0) {
+int ui_update_measurements(const measurement_channel_t* channels, size_t channel_count) {
+    if (!channels || channel_count == 0) {
+        return -1;
+    }
+    if (!measurement_channel_labels || channel_count > ui_config.measurement_channel_count) {
         return -1;
     }
+    if (atomic_get(&ui_suspended)) {
+        return 0;
+    }
+    bool any_ok = false;
     for (size_t i = 0; i < channel_count; i++) {
-        if (!measurements[i].ok) {
+        if (!channels[i].ok) {
             lv_label_set_text(measurement_channel_labels[i].voltage_label, "N/A V");
             lv_label_set_text(measurement_channel_labels[i].current_label, "N/A A");
             continue;
         }
         char buffer[32];
-        sprintf(buffer, "%.3f V", measurements[i].voltage);
+        sprintf(buffer, "%.3f V", channels[i].voltage);
         lv_label_set_text(measurement_channel_labels[i].voltage_label, buffer);
-        sprintf(buffer, "%.3f A", measurements[i].current);
+        sprintf(buffer, "%.3f A", channels[i].current);
         lv_label_set_text(measurement_channel_labels[i].current_label, buffer);
+        any_ok = true;
+    }
+    if (any_ok && dismiss_splash_screen()) {
+        boot_mark("splash dismissed");
     }
     return 0;
 }
 //----------------------------------------------------------------------------------------------------------------------
 int ui_update_button_pressed(int button_index) {
-    if (button_index == 0) {
-        lv_screen_load(measurement_screen);
-    } else if (button_index == 1) {
-        lv_screen_load(settings_screen);
-    } else if (button_index == 2) {
-        lv_screen_load(info_screen);
-    } else {
+    if (button_index < 0 || button_index > 2) {
         LOG_ERR("Invalid button index: %d", button_index);
         return -1;
     }
+    atomic_set(&ui_requested_screen, button_index);
     return 0;
 }
 //----------------------------------------------------------------------------------------------------------------------
+int ui_set_dimmed(bool dimmed) {
+    if (!display_dev) {
+        return -1;
+    }
+    uint8_t contrast = dimmed ? CONFIG_USB_PD_PSU_UI_DIM_CONTRAST : CONFIG_USB_PD_PSU_UI_CONTRAST;
+    return display_set_contrast(display_dev, contrast);
+}
+//----------------------------------------------------------------------------------------------------------------------
 int ui_loop(void) {
+    if (atomic_get(&ui_suspended)) {
+        return 0;
+    }
+    if (atomic_clear(&ui_invalidate_pending)) {
+        lv_obj_invalidate(lv_screen_active());
+    }
+    int requested_screen = atomic_set(&ui_requested_screen, -1);
+    if (requested_screen >= 0) {
+        load_requested_screen(requested_screen);
+    }
     lv_timer_handler();
     return 0;
 }
+//----------------------------------------------------------------------------------------------------------------------
+const struct device* ui_get_pm_device(void) {
+    return DEVICE_GET(ui_pm);
+}
 //----------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
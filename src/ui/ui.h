@@ -27,12 +27,8 @@
 //----------------------------------------------------------------------------------------------------------------------
 #include <stdbool.h>
 #include <stddef.h>
-//----------------------------------------------------------------------------------------------------------------------
-typedef struct {
-    double voltage;
-    double current;
-    bool ok;
-} ui_measurement_t;
+#include <zephyr/device.h>
+#include "measurement.h"
 //----------------------------------------------------------------------------------------------------------------------
 typedef struct {
     size_t measurement_channel_count;
@@ -42,8 +38,12 @@ int ui_init(ui_config_t config);
 //----------------------------------------------------------------------------------------------------------------------
 int ui_update_button_pressed(int button_index);
 //----------------------------------------------------------------------------------------------------------------------
-int ui_update_measurements(ui_measurement_t* measurements, size_t channel_count);
+int ui_update_measurements(const measurement_channel_t* channels, size_t channel_count);
+//----------------------------------------------------------------------------------------------------------------------
+int ui_set_dimmed(bool dimmed);
 //----------------------------------------------------------------------------------------------------------------------
 int ui_loop(void);
 //----------------------------------------------------------------------------------------------------------------------
+const struct device* ui_get_pm_device(void);
+//----------------------------------------------------------------------------------------------------------------------
 #endif  // UI_H
\ No newline at end of file